@@ -0,0 +1,59 @@
+#ifndef INPUT_H
+#define INPUT_H
+/*
+ * Purpose: Buffered reading of plain, gzip or zstd compressed input files.
+ */
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/* Size of the buffers input is read and decompressed through */
+#define INPUT_BUFFER 65536
+
+/* FNV-1a constants, used to fingerprint input files */
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME  1099511628211ULL
+
+/* Compression of an input file, detected from its first bytes */
+#define INPUT_PLAIN 0
+#define INPUT_GZIP  1
+#define INPUT_ZSTD  2
+
+/**
+ * An open input file. Compressed bytes are read into raw and decompressed
+ * into text, both of which are reused for the whole file. A plain file is
+ * read straight into text.
+ */
+struct input {
+  FILE          *file;        /* the underlying file                  */
+  const char    *name;        /* name of the file, for error messages */
+  int            compression; /* one of the INPUT_* codes             */
+  unsigned char *raw;         /* compressed bytes read from file      */
+  size_t         raw_pos;     /* next unused byte of raw              */
+  size_t         raw_len;     /* number of bytes held in raw          */
+  char          *text;        /* decompressed bytes                   */
+  size_t         text_pos;    /* next unread byte of text             */
+  size_t         text_len;    /* number of bytes held in text         */
+  int            in_frame;    /* TRUE inside an unfinished frame      */
+#ifdef HAVE_ZLIB
+  z_stream       gzip;        /* gzip decompression state             */
+#endif
+#ifdef HAVE_ZSTD
+  ZSTD_DStream  *zstd;        /* zstd decompression state             */
+#endif
+};
+
+struct input *input_open(const char *name);
+size_t input_gets       (char *buffer, int size, struct input *in);
+void input_close        (struct input *in);
+uint64_t input_size     (struct input *in);
+void input_seek         (struct input *in, uint64_t offset);
+uint64_t input_fingerprint(struct input *in);
+
+#endif
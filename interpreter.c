@@ -6,7 +6,7 @@
  * NOTE: The terms 'token' and 'lexeme' are used interchangeably in this
  *       program.
  *
- * USAGE: interpreter input_file.txt output_file.txt
+ * USAGE: interpreter [options] input_file.txt output_file.txt
  *
  * @author Kevin Filanowski
  * @version April 8, 2018
@@ -17,80 +17,240 @@
 #include "tokenizer.c"
 #include "parser.h"
 #include "parser.c"
+#include "results.h"
+#include "results.c"
+#include "input.h"
+#include "input.c"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 
 /** Global variable from tokenizer.c. Contains each line in the file. **/
-extern char * line;
+extern const char * line;
+
+/** Global variables from parser.c. Per-statement resource budgets. **/
+extern int max_tokens;
+extern int max_depth;
+extern int max_ops;
+extern int max_exponent;
+extern int budget_exceeded;
+
+/** FORMAT_TEXT or FORMAT_BINARY, chosen with --format. **/
+int format = FORMAT_TEXT;
+
+/** The part of the input to evaluate, chosen with --shard. **/
+int shard = 0;
+int shards = 1;
+
+/**
+ * Prints the usage message and exits.
+ */
+void usage(void) {
+  printf("Usage: interpreter [options] inputFile outputFile\n"
+         "Options:\n"
+         "  --format=F        text (default) or binary\n"
+         "  --shard=K/N       evaluate only part K of N of the input\n"
+         "  --max-tokens=N    tokens per statement       (default %d)\n"
+         "  --max-depth=N     nesting per statement      (default %d)\n"
+         "  --max-ops=N       operators per statement    (default %d)\n"
+         "  --max-exponent=N  largest exponent magnitude (default %d)\n",
+         MAX_TOKENS, MAX_DEPTH, MAX_OPS, MAX_EXPONENT);
+  exit(1);
+}
+
+/**
+ * Parses a single --name=value command line option.
+ * @param {char *} arg - The command line argument.
+ * @return {int} - TRUE if the option was recognized, FALSE otherwise.
+ */
+int parse_option(char *arg) {
+  char *value = strchr(arg, '=');
+  char *end;
+  int *budget = NULL;
+  long number;
+  int used = 0;
+
+  if (value == NULL)
+    return FALSE;
+
+  if (!strncmp(arg, "--format=", value - arg + 1)) {
+    if (!strcmp(value + 1, "text"))
+      format = FORMAT_TEXT;
+    else if (!strcmp(value + 1, "binary"))
+      format = FORMAT_BINARY;
+    else
+      return FALSE;
+    return TRUE;
+  }
+
+  if (!strncmp(arg, "--shard=", value - arg + 1)) {
+    if (sscanf(value + 1, "%d/%d%n", &shard, &shards, &used) != 2
+        || value[1 + used] != '\0')
+      return FALSE;
+    return 0 <= shard && shard < shards && shards <= MAX_SHARDS;
+  }
+
+  if (!strncmp(arg, "--max-tokens=", value - arg + 1))
+    budget = &max_tokens;
+  else if (!strncmp(arg, "--max-depth=", value - arg + 1))
+    budget = &max_depth;
+  else if (!strncmp(arg, "--max-ops=", value - arg + 1))
+    budget = &max_ops;
+  else if (!strncmp(arg, "--max-exponent=", value - arg + 1))
+    budget = &max_exponent;
+
+  if (budget == NULL || !isdigit(value[1]))
+    return FALSE;
+
+  //Reject trailing junk and values too large for an int.
+  errno = 0;
+  number = strtol(value + 1, &end, 10);
+  if (*end != '\0' || errno == ERANGE || number > INT_MAX)
+    return FALSE;
+  *budget = number;
+  return TRUE;
+}
+
+/**
+ * Finds the byte range of the input that belongs to this shard, and seeks to
+ * its start. The input is split into equal parts, and each line belongs to
+ * the shard its first byte falls in.
+ * @param {struct input *} in_file - The input file.
+ * @param {uint64_t *} start - Set to the offset of the first line to read.
+ * @param {uint64_t *} end - Set to the offset where the next shard begins.
+ */
+void find_shard(struct input *in_file, uint64_t *start, uint64_t *end) {
+  char skipped[LINE];    /* part of a line owned by the previous shard */
+  size_t read;           /* number of bytes in skipped                 */
+  uint64_t size = input_size(in_file);
+
+  *start = size * shard / shards;
+  *end = size * (shard + 1) / shards;
+  if (*start == 0)
+    return;
+
+  //Back up one byte, so a line starting exactly at start is kept, and skip
+  //to the end of the line there.
+  *start -= 1;
+  input_seek(in_file, *start);
+  while ((read = input_gets(skipped, LINE, in_file)) > 0) {
+    *start += read;
+    if (skipped[read - 1] == '\n')
+      break;
+  }
+}
 
 /**
  * The main function of the program. Interpreter.c
  * Takes command line input of a text file and sends each sentence
  * through a lexical analyzer and a parser to check for errors and evaluate
  * the total. It then prints the results to another file.
- * USAGE: interpreter input_file.txt output_file.txt
+ * USAGE: interpreter [options] input_file.txt output_file.txt
  */
 int main(int argc, char* argv[]) {
-  char temp_holder[LINE];/* Holds input_line temporarily                     */
   char input_line[LINE]; /* Line of input, fixed size                        */
-  FILE *in_file  = NULL; /* input file pointer                               */
+  struct input *in_file = NULL; /* input file, possibly compressed           */
   FILE *out_file = NULL; /* output file pointer                              */
-  int lexical_error;     /* FALSE if no lexical errors found, TRUE otherwise */
+  int column;            /* column of a lexical error in the line            */
+  int length;            /* length of the lexeme of a lexical error          */
   int value;             /* end total value of the statement per line        */
+  struct diagnostic diag;/* syntax error of the statement, if any            */
+  uint64_t offset = 0;   /* byte offset of input_line in the input file      */
+  uint64_t end = UINT64_MAX; /* offset where the next shard begins           */
+  size_t read;           /* number of bytes in input_line                    */
+  int new_line = TRUE;   /* TRUE if input_line starts a line of the file     */
+  uint32_t index = 0;    /* index of the next statement                      */
+  struct result_record record; /* result of the current statement            */
+  struct result_header header; /* header of a binary output file             */
+  int arg;               /* index of the current command line argument       */
 
-  if (argc != 3) {
-    printf("Usage: tokenizer inputFile outputFile\n");
-    exit(1);
+  for (arg = 1; arg < argc && !strncmp(argv[arg], "--", 2); arg++) {
+    if (!parse_option(argv[arg]))
+      usage();
   }
 
-  in_file = fopen(argv[1], "r");
-  if (in_file == NULL) {
-    fprintf(stderr, "ERROR: could not open %s for reading\n", argv[1]);
-    exit(1);
-  }
+  if (argc - arg != 2)
+    usage();
 
-  out_file = fopen(argv[2], "w");
+  in_file = input_open(argv[arg]);
+
+  out_file = fopen(argv[arg + 1], format == FORMAT_BINARY ? "wb" : "w");
   if (out_file == NULL) {
-    fprintf(stderr, "ERROR: could not open %s for writing\n", argv[2]);
+    fprintf(stderr, "ERROR: could not open %s for writing\n", argv[arg + 1]);
     exit(1);
   }
 
-  while (fgets(input_line, LINE, in_file) != NULL) {
+  //Record what the statements were run on, so shards can be matched up.
+  memset(&header, 0, sizeof(header));
+  header.shard = shard;
+  header.shards = shards;
+  if (format == FORMAT_BINARY && in_file->compression == INPUT_PLAIN) {
+    header.input_size = input_size(in_file);
+    header.input_hash = input_fingerprint(in_file);
+  }
+  header.max_tokens = max_tokens;
+  header.max_depth = max_depth;
+  header.max_ops = max_ops;
+  header.max_exponent = max_exponent;
+  write_result_header(out_file, format, &header);
+
+  //Fingerprinting reads from the start of the file, so find the shard after.
+  if (shards > 1)
+    find_shard(in_file, &offset, &end);
+
+  while ((read = input_gets(input_line, LINE, in_file)) > 0) {
+    //Stop at the first line that belongs to the next shard.
+    if (new_line && offset >= end)
+      break;
+
+    new_line = input_line[read - 1] == '\n';
+    record.offset = offset;
+    offset += read;
+
     //If the input_line is empty, then skip it.
-    strncpy(temp_holder, input_line, LINE);
-    squeeze_together(input_line);
-    if (!strncmp(input_line, "", LINE))
+    if (is_blank(input_line))
       continue;
 
     //Line is not empty, continue.
-    strncpy(input_line, temp_holder, LINE);
     line = input_line;
 
-    //Write line to file.
-    fprintf(out_file, "%s", line);
+    record.index = index++;
+    record.kind = 0;
+    record.reserved = 0;
 
-    //Find and print lexical errors in the current line.
-    lexical_error = tokenizer(out_file);
+    //Write line to file.
+    write_statement(out_file, format, input_line);
 
-    line = input_line;
+    //Find lexical errors in the current line.
+    if (tokenizer(&column, &length)) {
+      record.status = STATUS_LEXICAL;
+      record.kind = length;
+      record.value = column;
+    } else {
+      //Look for syntaxtical errors.
+      value = bexpr(input_line, &diag);
 
-    //Look for syntaxtical errors.
-    if (lexical_error == FALSE) {
-      value = bexpr(line);
-
-      //Print if there were no errors!
-      if (value != -999999)
-        fprintf(out_file, "Syntax OK\nValue is %d\n\n", value);
-      else {
-        if (strlen(line) > 2)
-          fprintf(out_file, "===> '%s' expected\nSyntax Error\n\n", line);
-        else
-          fprintf(out_file, "===> '%c' expected\nSyntax Error\n\n", *line);
+      //A statement that ran out of budget gets its own error block.
+      if (budget_exceeded != BUDGET_NONE) {
+        record.status = STATUS_RESOURCE;
+        record.kind = budget_exceeded;
+        record.value = 0;
+      } else if (value != ERROR) {
+        record.status = STATUS_OK;
+        record.value = value;
+      } else {
+        record.status = STATUS_SYNTAX;
+        record.kind = diag.expected;
+        record.value = diag.column;
       }
     }
+    write_result(out_file, format, input_line, &record);
   }
+  write_result_end(out_file, format, index);
   fclose(out_file);
-  fclose(in_file);
+  input_close(in_file);
   return 0;
 }
@@ -12,11 +12,33 @@
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <limits.h>
 #include "parser.h"
 #include "tokenizer.h"
 
 /** Global variable containing each line of the input file. **/
-extern char * line;
+extern const char * line;
+
+/** Per-statement resource budgets. May be overridden from the command line. **/
+int max_tokens   = MAX_TOKENS;
+int max_depth    = MAX_DEPTH;
+int max_ops      = MAX_OPS;
+int max_exponent = MAX_EXPONENT;
+
+/** The budget the current statement ran out of, or BUDGET_NONE. **/
+int budget_exceeded = BUDGET_NONE;
+
+/** Where syntax errors in the current statement are reported. **/
+static const char *line_start;
+static struct diagnostic *report;
+
+/** Resources used so far by the current statement. **/
+static int tokens_used;
+static int depth;
+static int ops_used;
+
+/** TRUE once a power is over budget or out of int's range. Reported later. **/
+static int exponent_exceeded;
 
 /**
  * <bexpr> ::= <expr> ;
@@ -36,26 +58,46 @@ extern char * line;
 
 /**
  * <bexpr> -> <expr>
- * Begins and ends the parse tree.
- * @param {char *} line_to_parse - A line from the input file to be parsed.
+ * Begins and ends the parse tree. The line itself is never modified.
+ * @param {const char *} line_to_parse - A line from the input file to be
+ *                                       parsed.
+ * @param {struct diagnostic *} diag - Set to the syntax error, if any.
  * @return {int} - The total computed value, or ERROR.
  */
-int bexpr(char *line_to_parse) {
-  char token[TSIZE];
+int bexpr(const char *line_to_parse, struct diagnostic *diag) {
+  char token[TSIZE] = "";  /* get_token() skips past the previous token */
   int result;
 
-  get_token(token);
+  line = line_start = line_to_parse;
+  report = diag;
+  report->expected = EXPECT_NONE;
+  report->column = 0;
+
+  //Every statement starts with a fresh budget.
+  budget_exceeded = BUDGET_NONE;
+  tokens_used = 0;
+  depth = 0;
+  ops_used = 0;
+  exponent_exceeded = FALSE;
+
+  next_token(token);
   result = expr(token);
 
-/** Added support for checking invalid left parenthesis **/
-  if (!strncmp(token, ")", 1)) {
-    strncpy(line, "(", LINE);
+  if (budget_exceeded != BUDGET_NONE)
     return ERROR;
-  } else if (strncmp(token, ";", 1) != 0) {
-    strncpy(line, ";", LINE);
+
+/** Added support for checking invalid left parenthesis **/
+  if (!strncmp(token, ")", 1))
+    return syntax_error(EXPECT_LEFT_PAREN);
+  else if (strncmp(token, ";", 1) != 0)
+    return syntax_error(EXPECT_SEMI_COLON);
+
+  //An exponent over budget only matters if the statement is otherwise valid.
+  if (exponent_exceeded && report->expected == EXPECT_NONE) {
+    budget_exceeded = BUDGET_EXPONENT;
     return ERROR;
-  } else
-    return result;
+  }
+  return result;
 }
 
 /**
@@ -86,6 +128,8 @@ int ttail(char *token, int subtotal) {
 
   //Check if the token is an add operator.
   if (!strncmp(token, "+", 1)) {
+    if (!charge_op())
+      return ERROR;
     add_sub_tok(token);
     term_value = term(token);
 
@@ -96,6 +140,8 @@ int ttail(char *token, int subtotal) {
       return ttail(token, (subtotal + term_value));
       //Check if the token is a subtract operator.
   } else if(!strncmp(token, "-", 1)) {
+      if (!charge_op())
+        return ERROR;
       add_sub_tok(token);
       term_value = term(token);
 
@@ -136,6 +182,8 @@ int stail(char *token, int subtotal) {
 
   //Searches for the multiplication operator.
   if (!strncmp(token, "*", 1)) {
+     if (!charge_op())
+       return ERROR;
      mul_div_tok(token);
      term_value = term(token);
 
@@ -145,6 +193,8 @@ int stail(char *token, int subtotal) {
      else
         return stail(token, (subtotal * term_value));
   } else if(!strncmp(token, "/", 1)) {
+     if (!charge_op())
+       return ERROR;
      mul_div_tok(token);
      term_value = term(token);
 
@@ -178,9 +228,15 @@ int stmt(char *token) {
 int ftail(char *token, int subtotal) {
   int val;
 
+  //Every comparison operator costs one operation.
+  if ((!strncmp(token, "<", 1) || !strncmp(token, ">", 1)
+       || !strncmp(token, "!=", 2) || !strncmp(token, "==", 2))
+      && !charge_op())
+    return ERROR;
+
   //Check for less than operator
   if (!strncmp(token, "<", 1)) {
-    get_token(token);
+    next_token(token);
     val = factor(token);
 
     if (val == ERROR)
@@ -191,7 +247,7 @@ int ftail(char *token, int subtotal) {
 
   //Check for greater than operator
   if (!strncmp(token, ">", 1)) {
-    get_token(token);
+    next_token(token);
     val = factor(token);
 
     if (val == ERROR)
@@ -202,7 +258,7 @@ int ftail(char *token, int subtotal) {
 
   //Check for less than or equal to operator
   if (!strncmp(token, "<=", 2)) {
-    get_token(token);
+    next_token(token);
     val = factor(token);
 
     if (val == ERROR)
@@ -213,7 +269,7 @@ int ftail(char *token, int subtotal) {
 
   //Check for greater than or equal to operator
   if (!strncmp(token, ">=", 2)) {
-    get_token(token);
+    next_token(token);
     val = factor(token);
 
     if (val == ERROR)
@@ -224,7 +280,7 @@ int ftail(char *token, int subtotal) {
 
   //Check for not equal to operator
   if (!strncmp(token, "!=", 2)) {
-    get_token(token);
+    next_token(token);
     val = factor(token);
 
     if (val == ERROR)
@@ -235,7 +291,7 @@ int ftail(char *token, int subtotal) {
 
   //Check for equal to operator
   if (!strncmp(token, "==", 2)) {
-    get_token(token);
+    next_token(token);
     val = factor(token);
 
     if (val == ERROR)
@@ -257,6 +313,7 @@ int ftail(char *token, int subtotal) {
  */
 int factor(char *token) {
   int factor_value;
+  double power;
   int subtotal = expp(token);
 
   //If subtotal is not a number, then error. Otherwise, check for exponents.
@@ -267,13 +324,30 @@ int factor(char *token) {
 
     //Check for an exponent.
     if (!strncmp(token, "^", 1)) {
-      get_token(token);
+      if (!charge_op() || !enter_nesting())
+        return ERROR;
+      next_token(token);
       factor_value = factor(token);
-
-      if (factor_value == ERROR)
-        return factor_value;
-      else
-        return pow(subtotal,factor_value);
+      depth--;
+
+      if (factor_value == ERROR || budget_exceeded != BUDGET_NONE)
+        return ERROR;
+
+      //Only a positive exponent can make the power grow, and not at all for
+      //a base of -1, 0 or 1. Parsing goes on after an exponent over budget,
+      //so a syntax error later in the line is still the one shown.
+      if ((subtotal < -1 || subtotal > 1) && factor_value > max_exponent) {
+        exponent_exceeded = TRUE;
+        return subtotal;
+      }
+
+      //Converting a power outside int's range back to int is undefined.
+      power = pow(subtotal, factor_value);
+      if (power < INT_MIN || power > INT_MAX) {
+        exponent_exceeded = TRUE;
+        return subtotal;
+      }
+      return power;
 
     } else
       return subtotal;
@@ -293,23 +367,23 @@ int expp(char *token) {
 
   //Check for left parenthesis
   if (!strncmp(token, "(", 1)) {
-    get_token(token);
+    if (!enter_nesting())
+      return ERROR;
+    next_token(token);
     value = expr(token);
+    depth--;
 
     //Check for the following right parenthesis
     if (!strncmp(token, ")", 1))
       return value;
-    else {
+    else
       //If no right parenthesis was found, throw an error.
-      strncpy(line, ")", 1);
-      return ERROR;
-    }
+      return syntax_error(EXPECT_RIGHT_PAREN);
 
     //Check for right parenthesis without a left parenthesis to match it.
-  } else if (!strncmp(token, ")", 1)) {
-    strncpy(line, "(", 1);
-    return ERROR;
-  }
+  } else if (!strncmp(token, ")", 1))
+    return syntax_error(EXPECT_LEFT_PAREN);
+
   return num(token);
 }
 
@@ -319,7 +393,7 @@ int expp(char *token) {
  * @param {char *} token - The current lexeme in the sentence.
  */
 void add_sub_tok(char *token) {
-  get_token(token);
+  next_token(token);
 }
 
 /**
@@ -328,7 +402,7 @@ void add_sub_tok(char *token) {
  * @param {char *} token - The current lexeme in the sentence.
  */
 void mul_div_tok(char *token) {
-  get_token(token);
+  next_token(token);
 }
 
 /**
@@ -337,7 +411,7 @@ void mul_div_tok(char *token) {
  * @param {char *} token - The current lexeme in the sentence.
  */
 void compare_tok(char *token) {
-  get_token(token);
+  next_token(token);
 }
 
 /**
@@ -351,9 +425,8 @@ int num(char *token) {
     return atoi(token);
   else {
     //We expected an int_literal here, so this will be the error.
-    strncpy(line, INT_LITERAL, LINE);
-    strncpy(token, ";", 1);
-    return ERROR;
+    token[0] = SEMI_COLON;
+    return syntax_error(EXPECT_INT_LITERAL);
   }
 }
 
@@ -363,7 +436,7 @@ int num(char *token) {
  * @param {char *} token - The current lexeme in the sentence.
  */
 void expon_tok(char *token) {
-  get_token(token);
+  next_token(token);
 }
 
 /**
@@ -387,3 +460,52 @@ int is_number(char *token) {
     return cmp1 == cmp2;
   }
 }
+
+/**
+ * Iterates to the next token, charging it against the token budget. Once any
+ * budget is exceeded the line is no longer scanned and the token is left
+ * empty, so every caller unwinds without doing further work.
+ * @param {char *} token - The current lexeme in the sentence.
+ */
+void next_token(char *token) {
+  if (budget_exceeded == BUDGET_NONE && ++tokens_used > max_tokens)
+    budget_exceeded = BUDGET_TOKENS;
+
+  if (budget_exceeded != BUDGET_NONE)
+    token[0] = '\0';
+  else
+    get_token(token);
+}
+
+/**
+ * Charges one operator against the operation budget.
+ * @return {int} - TRUE if the operator may be applied, FALSE otherwise.
+ */
+int charge_op(void) {
+  if (budget_exceeded == BUDGET_NONE && ++ops_used > max_ops)
+    budget_exceeded = BUDGET_OPS;
+  return budget_exceeded == BUDGET_NONE;
+}
+
+/**
+ * Enters one more level of parenthesis or exponent nesting. The caller must
+ * decrement depth again once the nested expression has been parsed.
+ * @return {int} - TRUE if the nesting is within budget, FALSE otherwise.
+ */
+int enter_nesting(void) {
+  if (budget_exceeded == BUDGET_NONE && ++depth > max_depth)
+    budget_exceeded = BUDGET_DEPTH;
+  return budget_exceeded == BUDGET_NONE;
+}
+
+/**
+ * Reports a syntax error at the current position in the line. A later error
+ * in the same statement replaces an earlier one.
+ * @param {int} expected - One of the EXPECT_* codes.
+ * @return {int} - ERROR, for the caller to return.
+ */
+int syntax_error(int expected) {
+  report->expected = expected;
+  report->column = line - line_start;
+  return ERROR;
+}
@@ -1,12 +1,41 @@
 #ifndef PARSER_H
 #define PARSER_H
 #define ERROR -999999
+
+/* Token kinds a syntax error can report as expected */
+#define EXPECT_NONE        0
+#define EXPECT_LEFT_PAREN  1
+#define EXPECT_RIGHT_PAREN 2
+#define EXPECT_SEMI_COLON  3
+#define EXPECT_INT_LITERAL 4
+
+/**
+ * A syntax error found by the parser: the kind of token that was expected,
+ * and the column of the line where it was expected.
+ */
+struct diagnostic {
+  int expected;  /* one of the EXPECT_* codes   */
+  int column;    /* offset into the parsed line */
+};
+
+/* Default per-statement resource budgets */
+#define MAX_TOKENS   LINE
+#define MAX_DEPTH    32
+#define MAX_OPS      64
+#define MAX_EXPONENT 64
+
+/* Budget codes, stored in budget_exceeded when a statement runs out */
+#define BUDGET_NONE     0
+#define BUDGET_TOKENS   1
+#define BUDGET_DEPTH    2
+#define BUDGET_OPS      3
+#define BUDGET_EXPONENT 4
 /*
  * Author:  William Kreahling and Mark Holliday and Kevin Filanowski
  * Purpose: Function Prototypes for parser.c
  * Date:    Modified 9-26-08, 3-25-15, 04-08-18
  */
-int bexpr (char *);
+int bexpr (const char *, struct diagnostic *);
 int expr  (char *);
 int term  (char *);
 int ttail (char *, int);
@@ -23,4 +52,9 @@ void expon_tok  (char *token);
 int num         (char *token);
 int is_number   (char *token);
 
+void next_token   (char *token);
+int charge_op     (void);
+int enter_nesting (void);
+int syntax_error  (int expected);
+
 #endif
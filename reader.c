@@ -0,0 +1,211 @@
+/**
+ * Reader.c
+ * This program converts binary result files written by
+ * 'interpreter --format=binary' back into the text format that the
+ * interpreter writes by default. The input file that was interpreted is
+ * needed as well, since the binary records do not repeat the statements.
+ *
+ * Given every shard written by 'interpreter --shard=K/N', it merges them into
+ * the same output a single run over the whole input would have written,
+ * either as text or, with --format=binary, as one binary result file.
+ *
+ * USAGE: reader [--format=binary] input_file.txt result_file.bin...
+ *               output_file.txt
+ */
+
+ /** Required Libraries **/
+#include "results.h"
+#include "results.c"
+#include "input.h"
+#include "input.c"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Prints the usage message and exits.
+ */
+void usage(void) {
+  printf("Usage: reader [--format=binary] inputFile resultFile... "
+         "outputFile\n");
+  exit(1);
+}
+
+/**
+ * Opens every shard of a result and orders them by shard number. Exits the
+ * program unless the files are exactly the shards of one run.
+ * @param {char **} names - The names of the result files.
+ * @param {int} count - The number of result files.
+ * @param {struct result_header *} run - Set to the header of the first file.
+ * @return {FILE **} - The result files, positioned after their headers.
+ */
+FILE **open_shards(char **names, int count, struct result_header *run) {
+  FILE **result_files = calloc(count, sizeof(FILE *));
+  FILE *result_file;
+  struct result_header header;
+  int i;
+
+  for (i = 0; i < count; i++) {
+    result_file = fopen(names[i], "rb");
+    if (result_file == NULL) {
+      fprintf(stderr, "ERROR: could not open %s for reading\n", names[i]);
+      exit(1);
+    }
+
+    if (!read_result_header(result_file, &header)) {
+      fprintf(stderr, "ERROR: %s is not a result file\n", names[i]);
+      exit(1);
+    }
+
+    if (header.shards != count) {
+      fprintf(stderr, "ERROR: %s is one of %d shards, but %d were given\n",
+              names[i], header.shards, count);
+      exit(1);
+    }
+
+    //Shards of another file, or run with other budgets, cannot be merged.
+    if (i == 0)
+      *run = header;
+    else if (!same_run(run, &header)) {
+      fprintf(stderr, "ERROR: %s is from a different run than %s\n",
+              names[i], names[0]);
+      exit(1);
+    }
+
+    if (result_files[header.shard] != NULL) {
+      fprintf(stderr, "ERROR: shard %d was given twice\n", header.shard);
+      exit(1);
+    }
+    result_files[header.shard] = result_file;
+  }
+  return result_files;
+}
+
+/**
+ * Reads the next record of a shard. Exits the program if the shard is cut
+ * short, since a shard without its end record is missing statements.
+ * @param {FILE *} result_file - The result file of the shard.
+ * @param {int} shard - The shard number, for error messages.
+ * @param {uint32_t} count - The number of statement records read so far.
+ * @param {struct result_record *} record - Where to store the record.
+ * @return {int} - TRUE for a statement record, FALSE at the end record.
+ */
+int read_record(FILE *result_file, int shard, uint32_t count,
+                struct result_record *record) {
+  size_t got = fread(record, 1, sizeof(*record), result_file);
+
+  if (got == sizeof(*record) && record->status != STATUS_END)
+    return TRUE;
+
+  //The end record must hold the count and be the last thing in the file.
+  if (got == sizeof(*record) && record->index == count
+      && fgetc(result_file) == EOF && feof(result_file))
+    return FALSE;
+
+  if (ferror(result_file))
+    fprintf(stderr, "ERROR: could not read shard %d\n", shard);
+  else
+    fprintf(stderr, "ERROR: shard %d is truncated or damaged\n", shard);
+  exit(1);
+}
+
+/**
+ * The main function of the program. Reader.c
+ * Reads each record of the result files shard by shard, finds its statement
+ * in the input file by byte offset, and prints both in the chosen format.
+ * USAGE: reader [--format=binary] input_file.txt result_file.bin...
+ *               output_file.txt
+ */
+int main(int argc, char* argv[]) {
+  char input_line[LINE];   /* Line of input, fixed size                      */
+  struct input *in_file = NULL; /* input file, possibly compressed           */
+  FILE **result_files;     /* result file of each shard, in order            */
+  FILE *out_file = NULL;   /* output file pointer                            */
+  int format = FORMAT_TEXT;/* format of the output file                      */
+  int count;               /* number of result files                         */
+  int arg = 1;             /* index of the current command line argument     */
+  int i;
+  uint64_t offset = 0;     /* byte offset of the next line of input          */
+  uint64_t start;          /* byte offset of input_line                      */
+  size_t read;             /* number of bytes in input_line                  */
+  uint64_t last = 0;       /* byte offset of the previous statement          */
+  uint32_t index = 0;      /* index of the next statement in the whole input */
+  uint32_t first;          /* index of the first statement of this shard     */
+  struct result_record record; /* the current result                         */
+  struct result_header header; /* header shared by every shard               */
+
+  if (arg < argc && !strcmp(argv[arg], "--format=binary")) {
+    format = FORMAT_BINARY;
+    arg++;
+  }
+
+  count = argc - arg - 2;
+  if (count < 1)
+    usage();
+
+  result_files = open_shards(argv + arg + 1, count, &header);
+
+  //Binary output does not repeat the statements, so needs no input.
+  if (format == FORMAT_TEXT) {
+    in_file = input_open(argv[arg]);
+
+    //A plain input must be the very file the statements were run on.
+    if (in_file->compression == INPUT_PLAIN && header.input_hash != 0
+        && (input_size(in_file) != header.input_size
+            || input_fingerprint(in_file) != header.input_hash)) {
+      fprintf(stderr, "ERROR: %s is not the input of these results\n",
+              argv[arg]);
+      exit(1);
+    }
+  }
+
+  out_file = fopen(argv[argc - 1], format == FORMAT_BINARY ? "wb" : "w");
+  if (out_file == NULL) {
+    fprintf(stderr, "ERROR: could not open %s for writing\n", argv[argc - 1]);
+    exit(1);
+  }
+
+  //The merged file looks just like the result of a single run.
+  header.shard = 0;
+  header.shards = 1;
+  write_result_header(out_file, format, &header);
+
+  for (i = 0; i < count; i++) {
+    first = index;
+    while (read_record(result_files[i], i, index - first, &record)) {
+      if (record.offset < last) {
+        fprintf(stderr, "ERROR: shard %d overlaps the shard before it\n", i);
+        exit(1);
+      }
+      last = record.offset;
+
+      //Shards number their statements from 0, so number them again.
+      record.index = index++;
+
+      if (format == FORMAT_TEXT) {
+        //Records are in input order, so skip ahead to the statement's line.
+        do {
+          start = offset;
+          read = input_gets(input_line, LINE, in_file);
+          if (read == 0) {
+            fprintf(stderr, "ERROR: statement %u is past the end of %s\n",
+                    record.index, argv[arg]);
+            exit(1);
+          }
+          offset += read;
+        } while (start < record.offset);
+
+        write_statement(out_file, format, input_line);
+      }
+      write_result(out_file, format, input_line, &record);
+    }
+    fclose(result_files[i]);
+  }
+  write_result_end(out_file, format, index);
+
+  fclose(out_file);
+  if (in_file != NULL)
+    input_close(in_file);
+  free(result_files);
+  return 0;
+}
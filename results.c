@@ -0,0 +1,159 @@
+/**
+ * results.c - Writes the result of each statement, either as the readable
+ *             text format or as fixed size binary records.
+ */
+
+ /** Required Libraries **/
+#include <string.h>
+#include <stdio.h>
+#include "results.h"
+#include "parser.h"
+#include "tokenizer.h"
+
+/**
+ * Writes the header of the output file. The text format has none.
+ * @param {FILE *} out_file - The file to write to.
+ * @param {int} format - FORMAT_TEXT or FORMAT_BINARY.
+ * @param {struct result_header *} header - The shard, input and budget
+ *                                          fields to write. The rest are
+ *                                          filled in here.
+ */
+void write_result_header(FILE *out_file, int format,
+                         struct result_header *header) {
+  if (format != FORMAT_BINARY)
+    return;
+
+  memcpy(header->magic, RESULT_MAGIC, sizeof(header->magic));
+  header->version = RESULT_VERSION;
+  header->record_size = sizeof(struct result_record);
+  header->byte_order = RESULT_BYTE_ORDER;
+  fwrite(header, sizeof(*header), 1, out_file);
+}
+
+/**
+ * Reads and checks the header of a binary result file.
+ * @param {FILE *} in_file - The file to read from.
+ * @param {struct result_header *} header - Where to store the header.
+ * @return {int} - TRUE if the header is one this program can read.
+ */
+int read_result_header(FILE *in_file, struct result_header *header) {
+  if (fread(header, sizeof(*header), 1, in_file) != 1)
+    return FALSE;
+  return !memcmp(header->magic, RESULT_MAGIC, sizeof(header->magic))
+      && header->version == RESULT_VERSION
+      && header->record_size == sizeof(struct result_record)
+      && header->byte_order == RESULT_BYTE_ORDER
+      && header->shard < header->shards;
+}
+
+/**
+ * Checks that two result files come from the same run: the same number of
+ * shards, over the same input, with the same budgets.
+ * @param {struct result_header *} a - The header of one file.
+ * @param {struct result_header *} b - The header of the other file.
+ * @return {int} - TRUE if the files can be merged.
+ */
+int same_run(struct result_header *a, struct result_header *b) {
+  return a->shards == b->shards
+      && a->input_size == b->input_size
+      && a->input_hash == b->input_hash
+      && a->max_tokens == b->max_tokens
+      && a->max_depth == b->max_depth
+      && a->max_ops == b->max_ops
+      && a->max_exponent == b->max_exponent;
+}
+
+/**
+ * Writes the statement itself, which only the text format repeats.
+ * @param {FILE *} out_file - The file to write to.
+ * @param {int} format - FORMAT_TEXT or FORMAT_BINARY.
+ * @param {char *} statement - The line of input holding the statement.
+ */
+void write_statement(FILE *out_file, int format, char *statement) {
+  if (format == FORMAT_TEXT)
+    fprintf(out_file, "%s", statement);
+}
+
+/**
+ * Writes the result of a statement.
+ * @param {FILE *} out_file - The file to write to.
+ * @param {int} format - FORMAT_TEXT or FORMAT_BINARY.
+ * @param {char *} statement - The line of input holding the statement. Only
+ *                             used to print the lexeme of a lexical error.
+ * @param {struct result_record *} record - The result to write.
+ */
+void write_result(FILE *out_file, int format, char *statement,
+                  struct result_record *record) {
+  if (format == FORMAT_BINARY) {
+    fwrite(record, sizeof(*record), 1, out_file);
+    return;
+  }
+
+  switch (record->status) {
+    case STATUS_OK:
+      fprintf(out_file, "Syntax OK\nValue is %d\n\n", (int) record->value);
+      break;
+    case STATUS_LEXICAL:
+      fprintf(out_file, "===> '%.*s'\nLexical error: not a lexeme\n\n",
+              record->kind, statement + record->value);
+      break;
+    case STATUS_SYNTAX:
+      fprintf(out_file, "===> '%s' expected\nSyntax Error\n\n",
+              expected_name(record->kind));
+      break;
+    case STATUS_RESOURCE:
+      fprintf(out_file, "===> '%s' budget exceeded\nResource Error\n\n",
+              budget_name(record->kind));
+      break;
+  }
+}
+
+/**
+ * Ends the output file. Binary files end with a STATUS_END record, so that a
+ * file cut short between two records can still be told from a whole one.
+ * @param {FILE *} out_file - The file to write to.
+ * @param {int} format - FORMAT_TEXT or FORMAT_BINARY.
+ * @param {uint32_t} count - The number of statement records written.
+ */
+void write_result_end(FILE *out_file, int format, uint32_t count) {
+  struct result_record record;
+
+  if (format != FORMAT_BINARY)
+    return;
+
+  memset(&record, 0, sizeof(record));
+  record.index = count;
+  record.status = STATUS_END;
+  fwrite(&record, sizeof(record), 1, out_file);
+}
+
+/**
+ * Gives the text of an expected token kind, as printed in error messages.
+ * @param {int} kind - One of the EXPECT_* codes.
+ * @return {const char *} - The expected token.
+ */
+const char *expected_name(int kind) {
+  switch (kind) {
+    case EXPECT_LEFT_PAREN:  return "(";
+    case EXPECT_RIGHT_PAREN: return ")";
+    case EXPECT_SEMI_COLON:  return ";";
+    case EXPECT_INT_LITERAL: return INT_LITERAL;
+  }
+  return "";
+}
+
+/**
+ * Gives the name of a budget, as used in error messages and on the command
+ * line.
+ * @param {int} budget - One of the BUDGET_* codes.
+ * @return {const char *} - The name of the budget.
+ */
+const char *budget_name(int budget) {
+  switch (budget) {
+    case BUDGET_TOKENS:   return "tokens";
+    case BUDGET_DEPTH:    return "depth";
+    case BUDGET_OPS:      return "ops";
+    case BUDGET_EXPONENT: return "exponent";
+  }
+  return "none";
+}
@@ -0,0 +1,82 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+/*
+ * Purpose: Result records and the text and binary output formats.
+ */
+#include <stdio.h>
+#include <stdint.h>
+
+/* Output formats */
+#define FORMAT_TEXT   0
+#define FORMAT_BINARY 1
+
+/* Binary format header constants */
+#define RESULT_MAGIC      "PRSR"
+#define RESULT_VERSION    4
+#define RESULT_BYTE_ORDER 0x01020304
+
+/* Status codes */
+#define STATUS_OK       0
+#define STATUS_LEXICAL  1
+#define STATUS_SYNTAX   2
+#define STATUS_RESOURCE 3
+#define STATUS_END      4
+
+/* Largest number of shards an input file can be split into */
+#define MAX_SHARDS 65535
+
+/**
+ * Header at the start of a binary result file. Records are written in host
+ * byte order; byte_order reads back as RESULT_BYTE_ORDER on a matching host.
+ * A file written by 'interpreter --shard=K/N' has shard K of shards N, and
+ * the indices of its records count from the start of the shard. The input
+ * fingerprint and the budgets tie the shards of one run together. The
+ * fingerprint is 0 for compressed input, which cannot be sharded.
+ */
+struct result_header {
+  char     magic[4];     /* RESULT_MAGIC, without the terminator    */
+  uint16_t version;      /* RESULT_VERSION                          */
+  uint16_t record_size;  /* sizeof(struct result_record)            */
+  uint32_t byte_order;   /* RESULT_BYTE_ORDER                       */
+  uint16_t shard;        /* which shard this is, counting from 0    */
+  uint16_t shards;       /* number of shards, 1 for a whole file    */
+  uint64_t input_size;   /* size of the input file in bytes         */
+  uint64_t input_hash;   /* input_fingerprint() of the input file   */
+  int32_t  max_tokens;   /* budgets the statements were run with    */
+  int32_t  max_depth;
+  int32_t  max_ops;
+  int32_t  max_exponent;
+};
+
+/**
+ * One fixed size record per statement. The meaning of kind and value
+ * depends on status:
+ *   STATUS_OK       - value is the computed value.
+ *   STATUS_LEXICAL  - value is the column of the bad lexeme, kind its length.
+ *   STATUS_SYNTAX   - kind is one of the EXPECT_* codes from parser.h,
+ *                     value the column where that token was expected.
+ *   STATUS_RESOURCE - kind is one of the BUDGET_* codes.
+ *   STATUS_END      - the last record of every binary file. index is the
+ *                     number of statement records before it.
+ */
+struct result_record {
+  uint64_t offset;       /* byte offset of the statement in the input */
+  uint32_t index;        /* index of the statement, counting from 0   */
+  uint8_t  status;       /* one of the STATUS_* codes                 */
+  uint8_t  kind;         /* error kind, see above                     */
+  uint16_t reserved;     /* always 0                                  */
+  int64_t  value;        /* value or error detail, see above          */
+};
+
+void write_result_header(FILE *out_file, int format,
+                         struct result_header *header);
+int read_result_header  (FILE *in_file, struct result_header *header);
+int same_run            (struct result_header *a, struct result_header *b);
+void write_statement    (FILE *out_file, int format, char *statement);
+void write_result       (FILE *out_file, int format, char *statement,
+                         struct result_record *record);
+void write_result_end   (FILE *out_file, int format, uint32_t count);
+const char *expected_name(int kind);
+const char *budget_name (int budget);
+
+#endif
@@ -16,24 +16,25 @@
 #include "tokenizer.h"
 #include <ctype.h>
 
-// Global pointer to line of input
-char *line;
+// Global pointer to line of input. The input itself is never modified.
+const char *line;
 
 /**
-* Main method. Opens the file, grabs tokens, and writes them to a file.
-* @param argc - Argument count
-* @param argv[] - Array of arguments
+* Scans the global line for lexical errors. The lexeme reported is the last
+* alphabetic word found, or if there is none, the last unrecognized character.
+* @param column - Set to the offset of the reported lexeme within the line.
+* @param length - Set to the length of the reported lexeme.
+* @return TRUE if a lexical error was found, FALSE otherwise.
 */
-int tokenizer(FILE *out_file) {
+int tokenizer(int *column, int *length) {
   char  token[TSIZE];      /* Spot to hold a token, fixed size         */
-  char  alpha[TSIZE];      /* Spot to hold numeric characters          */
-  char  error[TSIZE];      /* Spot to hold errors                      */
-  int   result = FALSE;    /* FALSE if no errors found, TRUE otherwise */
+  const char *start = line;/* Beginning of the line being scanned      */
+  int   alpha_column = -1; /* Offset of the last alphabetic lexeme     */
+  int   alpha_length = 0;  /* Length of the last alphabetic lexeme     */
+  int   error_column = -1; /* Offset of the last unrecognized char     */
 
-  //Reset token, alpha, and error after every new line.
+  //Reset token after every new line.
   strncpy(token, "", TSIZE);
-  strncpy(alpha, "", TSIZE);
-  strncpy(error, "", TSIZE);
 
   //Scan tokens for lexical errors.
   while (strlen(strstr(line, token)) > 1) {
@@ -46,35 +47,26 @@ int tokenizer(FILE *out_file) {
 
     //Lexical error found!
     if (strncmp(token, "ERROR", TSIZE) == 0) {
-      error[0] = line[0]; //Save the lexical error for later printing.
-      line++;             //Increment past the unrecognized token.
-      strncpy(token, "", TSIZE); //Reset the token.
+      error_column = line - start; //Save the lexical error for later.
+      line++;                      //Increment past the unrecognized token.
+      strncpy(token, "", TSIZE);   //Reset the token.
     } else if (isalpha(token[0])) {
-      strncpy(alpha, token, TSIZE);
+      alpha_column = line - start;
+      alpha_length = strlen(token);
     }
   }
-    if (strlen(error) != 0 || strlen(alpha) != 0) {  //Check Non-Lexemes.
-      file_write_error(out_file, alpha, error); //Write Unrecognized Token(s).
-      result = TRUE; //Error found.
-    }
-  return result;
-}
 
-/**
-* This method writes a formatted error message to the file.
-* @param out_file - A FILE type, the type to write the information to.
-**/
-void file_write_error(FILE *out_file, char *alpha, char* error) {
-  int i;
-  if (strlen(alpha) != 0) {
-    for (i = 0; i < strlen(alpha); i++) {
-      line++;
-    }
-    fprintf(out_file, "===> '%s'\nLexical error: not a lexeme\n\n", alpha);
-  } else {
-    fprintf(out_file, "===> '%s'\nLexical error: not a lexeme\n\n", error);
-    line++;
+  //Check Non-Lexemes.
+  if (alpha_column >= 0) {
+    *column = alpha_column;
+    *length = alpha_length;
+    return TRUE;
+  } else if (error_column >= 0) {
+    *column = error_column;
+    *length = 1;
+    return TRUE;
   }
+  return FALSE;
 }
 
 /**
@@ -137,8 +129,8 @@ void get_token(char *token_p) {
   }
 
   //Consider the possibility of the operator containing a second character.
-  //But only if the first character is not an INT_LITERAL.
-  if (!isdigit(line[i]) && line[i+1] == ASSIGN_OP)
+  //But only if the first character is not an INT_LITERAL or the line's end.
+  if (line[i] != '\0' && !isdigit(line[i]) && line[i+1] == ASSIGN_OP)
   temp[i+1] = ASSIGN_OP;
 
   //Scan the character(s) for alphanumerics.
@@ -169,31 +161,19 @@ void get_token(char *token_p) {
 }
 
 /**
-* This method removes all white space, tab, and newline characters from the
-* given string and returns the string without those characters. It then
-* modifies the original char_p parameter passed in through pointers.
-* @param string - A string to remove all delimiters from.
+* This method checks whether a string holds nothing but white space, tab,
+* and newline characters. The string is only scanned, never copied.
+* @param char_p - The string to check.
+* @return TRUE if the string is blank, FALSE otherwise.
 */
-void squeeze_together(char* char_p) {
-  int i;
-  int j = 0;
-  //Allocate a temporary string to hold the new string.
-  char *temp = calloc(LINE, sizeof(char));
-
-  //Iterate through the array and remove all tabs, white space, and newline
-  //characters.
-  for (i = 0; i < strlen(char_p); i++) {
-    if (char_p[i] != '\t'  && char_p[i] != ' '  && char_p[i] != '\n'
-    && char_p[i]  != '\0'  && char_p[i] != '\v' && char_p[i] != '\b'
-    && char_p[i]  != '\f'  && char_p[i] != '\r' && char_p[i] != '\a') {
-      temp[j++] = char_p[i];
-    }
+int is_blank(const char *char_p) {
+  for (; *char_p != '\0'; char_p++) {
+    if (*char_p != '\t'  && *char_p != ' '  && *char_p != '\n'
+    && *char_p  != '\v'  && *char_p != '\b' && *char_p != '\f'
+    && *char_p  != '\r'  && *char_p != '\a')
+      return FALSE;
   }
-  //Copy the new temporary line to the parameter passed in.
-  strncpy(char_p, temp, LINE);
-
-  //Since the temporary string was dynamically allocated, we will free it.
-  free(temp);
+  return TRUE;
 }
 
 /**
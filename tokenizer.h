@@ -35,9 +35,8 @@
 #define INT_LITERAL "int_literal"
 
 /** Helper methods for the tokenizer project. **/
-void file_write_error(FILE *out_file, char *alpha, char *error);
 void file_write_token(int *start, int *count, char *token_p, FILE *out_file);
 void get_token(char *token_p);
-int tokenizer(FILE *out_file);
-void squeeze_together(char *char_p);
+int tokenizer(int *column, int *length);
+int is_blank(const char *char_p);
 void string_after_token(char *token_p);